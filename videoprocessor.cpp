@@ -5,10 +5,100 @@
 #include <QDateTime>
 #include <QUrl>
 #include <QTextStream>
+#include <QCryptographicHash>
+#include <QSet>
+#include <QFuture>
+#include <QtConcurrent/QtConcurrentRun>
 #include <algorithm>
+#include <numeric>
+#include <queue>
+#include <vector>
+
+bool RunCache::lookup(const QString &root, const QByteArray &signature, int sortType,
+                      QList<VideoEntry> &entries, QVector<int> &order) {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_runs.constFind(root);
+    if (it == m_runs.constEnd() || it->signature != signature) return false;
+    entries = it->entries;
+    order = it->orders.value(sortType);
+    return true;
+}
+
+void RunCache::store(const QString &root, const QByteArray &signature, const QList<VideoEntry> &entries) {
+    QMutexLocker locker(&m_mutex);
+
+    // Forget probes of files that are no longer part of this root
+    auto previous = m_runs.constFind(root);
+    if (previous != m_runs.constEnd()) {
+        QSet<QString> current;
+        current.reserve(entries.size());
+        for (const VideoEntry &entry : entries) {
+            current.insert(entry.filePath);
+        }
+        for (const VideoEntry &entry : previous->entries) {
+            if (!current.contains(entry.filePath)) {
+                m_entries.remove(entry.filePath);
+            }
+        }
+    }
+
+    CachedRun run;
+    run.signature = signature;
+    run.entries = entries;
+    m_runs.insert(root, run);
+}
+
+void RunCache::storeOrder(const QString &root, const QByteArray &signature, int sortType, const QVector<int> &order) {
+    QMutexLocker locker(&m_mutex);
+    auto it = m_runs.find(root);
+    if (it == m_runs.end() || it->signature != signature) return;
+    it->orders.insert(sortType, order);
+}
+
+bool RunCache::lookupEntry(const QString &filePath, VideoEntry &entry) {
+    QFileInfo info(filePath);
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(filePath);
+    if (it == m_entries.constEnd() || it->fileSize != info.size()
+        || it->lastModified != info.lastModified().toMSecsSinceEpoch()) {
+        return false;
+    }
+    entry = *it;
+    return true;
+}
+
+void RunCache::storeEntry(const VideoEntry &entry) {
+    QMutexLocker locker(&m_mutex);
+    m_entries.insert(entry.filePath, entry);
+}
+
+void RunCache::releaseEntries(const QStringList &filePaths) {
+    QMutexLocker locker(&m_mutex);
+
+    // Files that still belong to a cached root stay, they are needed when that root is rebuilt
+    QSet<QString> inRuns;
+    for (const CachedRun &run : qAsConst(m_runs)) {
+        for (const VideoEntry &entry : run.entries) {
+            inRuns.insert(entry.filePath);
+        }
+    }
+    for (const QString &filePath : filePaths) {
+        if (!inRuns.contains(filePath)) {
+            m_entries.remove(filePath);
+        }
+    }
+}
 
 VideoProcessor::VideoProcessor(const QString &directory, bool verbose, SortType sortType)
-    : m_directory(directory), m_verbose(verbose), m_sortType(sortType) {
+    : VideoProcessor(QStringList() << directory, verbose, sortType) {
+}
+
+VideoProcessor::VideoProcessor(const QStringList &directories, bool verbose, SortType sortType,
+                               QSharedPointer<RunCache> runCache)
+    : m_directories(directories), m_verbose(verbose), m_sortType(sortType), m_runCache(runCache) {
+    if (!m_runCache) {
+        m_runCache = QSharedPointer<RunCache>::create();
+    }
     QString logFileName = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + "_vlc_playlist_creator.log";
     m_logFile.setFileName(logFileName);
     m_logFile.open(QIODevice::WriteOnly | QIODevice::Text);
@@ -17,25 +107,58 @@ VideoProcessor::VideoProcessor(const QString &directory, bool verbose, SortType
 
 void VideoProcessor::process(const QString &outputPath) {
     log("Starting process");
-    QDir dir(m_directory);
-    if (!dir.exists()) {
-        emit errorOccurred("Directory does not exist: " + m_directory);
-        log("Error: Directory does not exist: " + m_directory);
+
+    QStringList roots;
+    QStringList missingRoots;
+    for (const QString &directory : qAsConst(m_directories)) {
+        QString root = normalizePath(directory);
+        if (roots.contains(root) || missingRoots.contains(root)) continue;
+        if (QDir(root).exists()) {
+            roots.append(root);
+        } else {
+            missingRoots.append(root);
+            log("Error: Directory does not exist: " + root);
+        }
+    }
+
+    if (roots.isEmpty()) {
+        emit errorOccurred("Directory does not exist: " + missingRoots.join(", "));
         emit finished();
         return;
     }
 
-    QStringList videoFiles = findVideoFiles(m_directory);
-    if (videoFiles.isEmpty()) {
-        emit errorOccurred("No video files found in directory: " + m_directory);
-        log("Error: No video files found in directory: " + m_directory);
+    if (!missingRoots.isEmpty()) {
+        emit errorOccurred("Skipping directories that do not exist: " + missingRoots.join(", "));
+    }
+
+    // Each root is scanned, probed and sorted on its own thread. Root builds can run for minutes, so they get
+    // a pool of their own and the global pool stays free for the playlist's short validation jobs.
+    QList<QFuture<QList<VideoEntry>>> futures;
+    for (const QString &root : qAsConst(roots)) {
+        futures.append(QtConcurrent::run(&m_rootPool, [this, root]() { return buildRun(root); }));
+    }
+
+    QList<QList<VideoEntry>> runs;
+    int totalFiles = 0;
+    for (const QFuture<QList<VideoEntry>> &future : qAsConst(futures)) {
+        QList<VideoEntry> run = future.result();
+        totalFiles += run.size();
+        if (!run.isEmpty()) {
+            runs.append(run);
+        }
+    }
+
+    if (totalFiles == 0) {
+        emit errorOccurred("No video files found in directory: " + roots.join(", "));
+        log("Error: No video files found in directory: " + roots.join(", "));
         emit finished();
         return;
     }
-    
-    log("Found " + QString::number(videoFiles.size()) + " video files");
 
-    QString output = generatePlaylist(videoFiles, outputPath);
+    QList<VideoEntry> merged = mergeRuns(runs);
+    log("Found " + QString::number(merged.size()) + " video files in " + QString::number(runs.size()) + " directories");
+
+    QString output = writePlaylist(merged, outputPath);
 
     emit outputGenerated(output);
     log("Process completed");
@@ -44,51 +167,125 @@ void VideoProcessor::process(const QString &outputPath) {
 
 void VideoProcessor::processManualPlaylist(const QStringList &filePaths, const QString &outputPath) {
     log("Starting manual playlist process");
-    
+
     if (filePaths.isEmpty()) {
         emit errorOccurred("No files provided for manual playlist");
         log("Error: No files provided for manual playlist");
         emit finished();
         return;
     }
-    
-    log("Processing " + QString::number(filePaths.size()) + " files");
 
-    QString output = generatePlaylist(filePaths, outputPath);
+    // Files may have been moved or deleted since they were added to the playlist
+    VideoValidationResult validated = validateVideoFiles(filePaths);
+    if (validated.missing + validated.notVideo + validated.duplicates > 0) {
+        log("Skipped " + QString::number(validated.missing) + " missing, "
+            + QString::number(validated.notVideo) + " non-video and "
+            + QString::number(validated.duplicates) + " duplicate entries");
+    }
+
+    if (validated.accepted.isEmpty()) {
+        emit errorOccurred("None of the files in the manual playlist are available");
+        log("Error: None of the files in the manual playlist are available");
+        emit finished();
+        return;
+    }
+
+    log("Processing " + QString::number(validated.accepted.size()) + " files");
+
+    QString output = generatePlaylist(validated.accepted, outputPath);
 
     emit outputGenerated(output);
     log("Manual playlist process completed");
     emit finished();
 }
 
-QString VideoProcessor::generatePlaylist(const QStringList &videoFiles, const QString &outputPath) {
-    QList<QPair<QString, int>> videoQualityList;
+QList<VideoEntry> VideoProcessor::buildRun(const QString &root) {
+    QStringList videoFiles = findVideoFiles(root);
+    QByteArray signature = computeSignature(videoFiles);
+
+    QList<VideoEntry> entries;
+    QVector<int> order;
+    if (m_runCache->lookup(root, signature, m_sortType, entries, order)) {
+        log("Reusing probed files for unchanged directory: " + root);
+    } else {
+        log("Found " + QString::number(videoFiles.size()) + " video files in " + root);
+        for (const QString &filePath : qAsConst(videoFiles)) {
+            entries.append(probeVideo(filePath));
+        }
+        m_runCache->store(root, signature, entries);
+    }
+
+    if (m_sortType == NoSort) return entries;
 
+    if (order.isEmpty()) {
+        order = sortOrder(entries);
+        m_runCache->storeOrder(root, signature, m_sortType, order);
+    }
+    return applyOrder(entries, order);
+}
+
+QByteArray VideoProcessor::computeSignature(const QStringList &videoFiles) {
+    // Path, size and mtime are enough to notice added, removed or replaced files without probing them
+    QCryptographicHash hash(QCryptographicHash::Sha1);
     for (const QString &filePath : videoFiles) {
-        log("Processing file: " + filePath);
-        QString videoCodec = getVideoCodec(filePath);
-        QString videoResolution = getVideoResolution(filePath);
-        double videoBitrate = getVideoBitrate(filePath);
-        QString audioCodec = getAudioCodec(filePath);
-        int audioBitrate = getAudioBitrate(filePath);
-        int duration = getVideoDuration(filePath);
-        qint64 fileSize = getFileSize(filePath);
-
-        int qualityScore = 0;
-        qualityScore += videoCodec.contains("h264", Qt::CaseInsensitive) ? 10 : 5;
-        qualityScore += videoResolution.contains("1920x1080") ? 20 : (videoResolution.contains("1280x720") ? 10 : 5);
-        qualityScore += static_cast<int>(videoBitrate / 1000);
-        qualityScore += audioCodec.contains("aac", Qt::CaseInsensitive) ? 10 : 5;
-        qualityScore += audioBitrate / 32;
-        qualityScore += duration / 60000; // Add points for longer videos (1 point per minute)
-        qualityScore += static_cast<int>(fileSize / (1024 * 1024)); // Add points for larger files (1 point per MB)
-
-        videoQualityList.append(qMakePair(filePath, qualityScore));
-        log("File processed: " + filePath + ", Quality Score: " + QString::number(qualityScore));
+        QFileInfo info(filePath);
+        hash.addData(filePath.toUtf8());
+        hash.addData(QByteArray::number(info.size()));
+        hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
     }
+    return hash.result();
+}
+
+VideoEntry VideoProcessor::probeVideo(const QString &filePath) {
+    VideoEntry entry;
+    if (m_runCache->lookupEntry(filePath, entry)) {
+        log("Using cached probe for file: " + filePath);
+        return entry;
+    }
+
+    log("Processing file: " + filePath);
+    QString videoCodec = getVideoCodec(filePath);
+    QString videoResolution = getVideoResolution(filePath);
+    double videoBitrate = getVideoBitrate(filePath);
+    QString audioCodec = getAudioCodec(filePath);
+    int audioBitrate = getAudioBitrate(filePath);
+    int duration = getVideoDuration(filePath);
+    qint64 fileSize = getFileSize(filePath);
+
+    int qualityScore = 0;
+    qualityScore += videoCodec.contains("h264", Qt::CaseInsensitive) ? 10 : 5;
+    qualityScore += videoResolution.contains("1920x1080") ? 20 : (videoResolution.contains("1280x720") ? 10 : 5);
+    qualityScore += static_cast<int>(videoBitrate / 1000);
+    qualityScore += audioCodec.contains("aac", Qt::CaseInsensitive) ? 10 : 5;
+    qualityScore += audioBitrate / 32;
+    qualityScore += duration / 60000; // Add points for longer videos (1 point per minute)
+    qualityScore += static_cast<int>(fileSize / (1024 * 1024)); // Add points for larger files (1 point per MB)
+
+    log("File processed: " + filePath + ", Quality Score: " + QString::number(qualityScore));
+
+    QFileInfo info(filePath);
+    entry.filePath = filePath;
+    entry.fileName = info.fileName();
+    entry.qualityScore = qualityScore;
+    entry.duration = duration;
+    entry.fileSize = fileSize;
+    entry.lastModified = info.lastModified().toMSecsSinceEpoch();
+    m_runCache->storeEntry(entry);
+    return entry;
+}
+
+QString VideoProcessor::generatePlaylist(const QStringList &videoFiles, const QString &outputPath) {
+    QList<VideoEntry> videoList;
+    for (const QString &filePath : videoFiles) {
+        videoList.append(probeVideo(filePath));
+    }
+
+    sortVideoFiles(videoList);
 
-    sortVideoFiles(videoQualityList);
+    return writePlaylist(videoList, outputPath);
+}
 
+QString VideoProcessor::writePlaylist(const QList<VideoEntry> &videoList, const QString &outputPath) {
     QString output;
     QTextStream stream(&output);
     stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
@@ -97,21 +294,20 @@ QString VideoProcessor::generatePlaylist(const QStringList &videoFiles, const QS
     stream << "\t<trackList>\n";
 
     int trackId = 0;
-    for (const auto &video : videoQualityList) {
+    for (const VideoEntry &video : videoList) {
         stream << "\t\t<track>\n";
 
-        QString filePath = QDir::toNativeSeparators(video.first);
+        QString filePath = QDir::toNativeSeparators(video.filePath);
         filePath.replace(0, 2, "C:");  // Replace 'c:' with 'C:'
         QString encodedPath = QUrl::toPercentEncoding(filePath, ":/");
         stream << "\t\t\t<location>file:///" << encodedPath << "</location>\n";
 
-        int duration = getVideoDuration(video.first);
-        stream << "\t\t\t<duration>" << duration << "</duration>\n";
-        
+        stream << "\t\t\t<duration>" << video.duration << "</duration>\n";
+
         stream << "\t\t\t<extension application=\"http://www.videolan.org/vlc/playlist/0\">\n";
         stream << "\t\t\t\t<vlc:id>" << trackId << "</vlc:id>\n";
         stream << "\t\t\t</extension>\n";
-        
+
         stream << "\t\t</track>\n";
 
         trackId++;
@@ -119,11 +315,11 @@ QString VideoProcessor::generatePlaylist(const QStringList &videoFiles, const QS
 
     stream << "\t</trackList>\n";
     stream << "\t<extension application=\"http://www.videolan.org/vlc/playlist/0\">\n";
-    
+
     for (int i = 0; i < trackId; i++) {
         stream << "\t\t<vlc:item tid=\"" << i << "\"/>\n";
     }
-    
+
     stream << "\t</extension>\n";
     stream << "</playlist>\n";
 
@@ -142,57 +338,156 @@ QString VideoProcessor::generatePlaylist(const QStringList &videoFiles, const QS
     return output;
 }
 
-void VideoProcessor::sortVideoFiles(QList<QPair<QString, int>> &videoList) {
+bool VideoProcessor::lessThan(const VideoEntry &a, const VideoEntry &b) const {
     switch (m_sortType) {
         case Quality:
-            std::sort(videoList.begin(), videoList.end(),
-                      [](const QPair<QString, int> &a, const QPair<QString, int> &b) {
-                          return a.second > b.second;
-                      });
-            break;
+            return a.qualityScore > b.qualityScore;
         case Name:
-            std::sort(videoList.begin(), videoList.end(),
-                      [](const QPair<QString, int> &a, const QPair<QString, int> &b) {
-                          return QFileInfo(a.first).fileName() < QFileInfo(b.first).fileName();
-                      });
-            break;
+            return a.fileName < b.fileName;
         case Duration:
-            std::sort(videoList.begin(), videoList.end(),
-                      [this](const QPair<QString, int> &a, const QPair<QString, int> &b) {
-                          return getVideoDuration(a.first) > getVideoDuration(b.first);
-                      });
-            break;
+            return a.duration > b.duration;
         case Size:
-            std::sort(videoList.begin(), videoList.end(),
-                      [this](const QPair<QString, int> &a, const QPair<QString, int> &b) {
-                          return getFileSize(a.first) > getFileSize(b.first);
-                      });
-            break;
+            return a.fileSize > b.fileSize;
         case NoSort:
         default:
-            break;
+            return false;
     }
 }
 
+QVector<int> VideoProcessor::sortOrder(const QList<VideoEntry> &videoList) const {
+    QVector<int> order(videoList.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (m_sortType != NoSort) {
+        std::stable_sort(order.begin(), order.end(),
+                         [this, &videoList](int a, int b) {
+                             return lessThan(videoList.at(a), videoList.at(b));
+                         });
+    }
+    return order;
+}
+
+QList<VideoEntry> VideoProcessor::applyOrder(const QList<VideoEntry> &videoList, const QVector<int> &order) {
+    QList<VideoEntry> sorted;
+    sorted.reserve(order.size());
+    for (int index : order) {
+        sorted.append(videoList.at(index));
+    }
+    return sorted;
+}
+
+void VideoProcessor::sortVideoFiles(QList<VideoEntry> &videoList) {
+    if (m_sortType == NoSort) return;
+    videoList = applyOrder(videoList, sortOrder(videoList));
+}
+
+QList<VideoEntry> VideoProcessor::mergeRuns(const QList<QList<VideoEntry>> &runs) {
+    struct Cursor {
+        int run;
+        int pos;
+    };
+
+    // Min-heap on the head of each run; ties go to the earlier root, so NoSort keeps root order
+    auto lowerPriority = [this, &runs](const Cursor &a, const Cursor &b) {
+        const VideoEntry &entryA = runs.at(a.run).at(a.pos);
+        const VideoEntry &entryB = runs.at(b.run).at(b.pos);
+        if (lessThan(entryB, entryA)) return true;
+        if (lessThan(entryA, entryB)) return false;
+        return a.run > b.run;
+    };
+    std::priority_queue<Cursor, std::vector<Cursor>, decltype(lowerPriority)> heap(lowerPriority);
+
+    int totalEntries = 0;
+    for (int i = 0; i < runs.size(); ++i) {
+        totalEntries += runs.at(i).size();
+        if (!runs.at(i).isEmpty()) {
+            heap.push(Cursor{i, 0});
+        }
+    }
+
+    // Nested roots scan the same files more than once; keep the first occurrence only
+    QSet<QString> seen;
+    seen.reserve(totalEntries);
+    QList<VideoEntry> merged;
+    merged.reserve(totalEntries);
+    while (!heap.empty()) {
+        Cursor cursor = heap.top();
+        heap.pop();
+        const VideoEntry &entry = runs.at(cursor.run).at(cursor.pos);
+        if (!seen.contains(entry.filePath)) {
+            seen.insert(entry.filePath);
+            merged.append(entry);
+        }
+        if (++cursor.pos < runs.at(cursor.run).size()) {
+            heap.push(cursor);
+        }
+    }
+
+    return merged;
+}
+
+QStringList VideoProcessor::videoExtensions() {
+    static const QStringList extensions = {"mp4", "avi", "mkv", "mov", "wmv", "flv", "webm"};
+    return extensions;
+}
+
+bool VideoProcessor::isVideoFile(const QString &filePath) {
+    return videoExtensions().contains(QFileInfo(filePath).suffix().toLower());
+}
+
 QStringList VideoProcessor::findVideoFiles(const QString &directory) {
     QStringList videoFiles;
     QDir dir(directory);
-    QStringList videoExtensions = {"*.mp4", "*.avi", "*.mkv", "*.mov", "*.wmv", "*.flv", "*.webm"};
-    
+
     QFileInfoList entries = dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot);
     for (const QFileInfo &entry : entries) {
         if (entry.isDir()) {
             videoFiles.append(findVideoFiles(entry.filePath()));
         } else if (entry.isFile()) {
-            if (videoExtensions.contains("*." + entry.suffix().toLower())) {
+            if (isVideoFile(entry.filePath())) {
                 videoFiles.append(entry.filePath());
             }
         }
     }
-    
+
     return videoFiles;
 }
 
+QString VideoProcessor::normalizePath(const QString &path) {
+    return QDir::cleanPath(QFileInfo(path).absoluteFilePath());
+}
+
+VideoValidationResult VideoProcessor::validateVideoFiles(const QStringList &paths) {
+    VideoValidationResult result;
+    QSet<QString> seen;
+
+    auto accept = [&result, &seen](const QString &filePath) {
+        QString normalized = normalizePath(filePath);
+        if (seen.contains(normalized)) {
+            result.duplicates++;
+            return;
+        }
+        seen.insert(normalized);
+        result.accepted.append(normalized);
+    };
+
+    for (const QString &path : paths) {
+        QFileInfo info(path);
+        if (!info.exists()) {
+            result.missing++;
+        } else if (info.isDir()) {
+            for (const QString &filePath : findVideoFiles(info.filePath())) {
+                accept(filePath);
+            }
+        } else if (!info.isFile() || !isVideoFile(path)) {
+            result.notVideo++;
+        } else {
+            accept(path);
+        }
+    }
+
+    return result;
+}
+
 int VideoProcessor::getVideoDuration(const QString &filePath) {
     QProcess process;
     process.start("ffprobe", QStringList() << "-v" << "error" << "-show_entries" << "format=duration" 
@@ -257,6 +552,7 @@ QString VideoProcessor::getFileExtension(const QString &filePath) {
 
 void VideoProcessor::log(const QString &message) {
     QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss");
+    QMutexLocker locker(&m_logMutex); // Runs are built on pool threads
     m_logStream << timestamp << " - " << message << "\n";
     m_logStream.flush();
     emit logMessage(timestamp + " - " + message);
@@ -6,6 +6,57 @@
 #include <QFile>
 #include <QTextStream>
 #include <QStringList>
+#include <QList>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QThreadPool>
+
+struct VideoEntry {
+    QString filePath;
+    QString fileName;
+    int qualityScore;
+    int duration;
+    qint64 fileSize;
+    qint64 lastModified;
+};
+
+// Outcome of checking a batch of user-supplied paths. Folders are expanded to the videos they contain.
+struct VideoValidationResult {
+    QStringList accepted;
+    int missing = 0;
+    int notVideo = 0;
+    int duplicates = 0;
+};
+
+// Keeps each root's probed entries between builds so that only roots whose contents changed are probed again.
+// Entries are stored unsorted together with one index order per sort type, so an unchanged root comes back
+// ready to merge. Single files are also cached by path, which lets manual playlists and changed roots skip
+// ffprobe for files that were already probed. Those are pruned when a file leaves its root or is released
+// from the manual playlist.
+class RunCache {
+public:
+    bool lookup(const QString &root, const QByteArray &signature, int sortType,
+                QList<VideoEntry> &entries, QVector<int> &order);
+    void store(const QString &root, const QByteArray &signature, const QList<VideoEntry> &entries);
+    void storeOrder(const QString &root, const QByteArray &signature, int sortType, const QVector<int> &order);
+    bool lookupEntry(const QString &filePath, VideoEntry &entry);
+    void storeEntry(const VideoEntry &entry);
+    void releaseEntries(const QStringList &filePaths);
+
+private:
+    struct CachedRun {
+        QByteArray signature;
+        QList<VideoEntry> entries;
+        QHash<int, QVector<int>> orders;
+    };
+
+    QMutex m_mutex;
+    QHash<QString, CachedRun> m_runs;
+    QHash<QString, VideoEntry> m_entries;
+};
 
 class VideoProcessor : public QObject {
     Q_OBJECT
@@ -20,6 +71,14 @@ public:
     };
 
     VideoProcessor(const QString &directory, bool verbose, SortType sortType);
+    VideoProcessor(const QStringList &directories, bool verbose, SortType sortType,
+                   QSharedPointer<RunCache> runCache = QSharedPointer<RunCache>());
+
+    static QStringList videoExtensions();
+    static bool isVideoFile(const QString &filePath);
+    static QStringList findVideoFiles(const QString &directory);
+    static QString normalizePath(const QString &path);
+    static VideoValidationResult validateVideoFiles(const QStringList &paths);
 
 public slots:
     void process(const QString &outputPath);
@@ -32,13 +91,15 @@ signals:
     void finished();
 
 private:
-    QString m_directory;
+    QStringList m_directories;
     bool m_verbose;
     SortType m_sortType;
+    QSharedPointer<RunCache> m_runCache;
     QFile m_logFile;
     QTextStream m_logStream;
-    
-    QStringList findVideoFiles(const QString &directory);
+    QMutex m_logMutex;
+    QThreadPool m_rootPool;
+
     int getVideoDuration(const QString &filePath);
     QString getVideoCodec(const QString &filePath);
     QString getVideoResolution(const QString &filePath);
@@ -48,8 +109,16 @@ private:
     qint64 getFileSize(const QString &filePath);
     QString getFileExtension(const QString &filePath);
     void log(const QString &message);
+    QList<VideoEntry> buildRun(const QString &root);
+    QByteArray computeSignature(const QStringList &videoFiles);
+    VideoEntry probeVideo(const QString &filePath);
     QString generatePlaylist(const QStringList &videoFiles, const QString &outputPath);
-    void sortVideoFiles(QList<QPair<QString, int>> &videoList);
+    QString writePlaylist(const QList<VideoEntry> &videoList, const QString &outputPath);
+    bool lessThan(const VideoEntry &a, const VideoEntry &b) const;
+    QVector<int> sortOrder(const QList<VideoEntry> &videoList) const;
+    static QList<VideoEntry> applyOrder(const QList<VideoEntry> &videoList, const QVector<int> &order);
+    void sortVideoFiles(QList<VideoEntry> &videoList);
+    QList<VideoEntry> mergeRuns(const QList<QList<VideoEntry>> &runs);
 };
 
-#endif // VIDEOPROCESSOR_H
\ No newline at end of file
+#endif // VIDEOPROCESSOR_H
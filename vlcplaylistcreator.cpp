@@ -9,10 +9,17 @@
 #include <QLabel>
 #include <QComboBox>
 #include <QStandardPaths>
+#include <QFutureWatcher>
+#include <QMimeData>
+#include <QUrl>
+#include <QtConcurrent/QtConcurrentRun>
 
 VLCPlaylistCreator::VLCPlaylistCreator(QWidget *parent) 
-    : QMainWindow(parent), m_settings("VLCPlaylistCreator", "VLCPlaylistCreator") {
+    : QMainWindow(parent), m_settings("VLCPlaylistCreator", "VLCPlaylistCreator"),
+      m_runCache(QSharedPointer<RunCache>::create()), m_pendingValidations(0), m_validationGeneration(0),
+      m_nextBatchSequence(0), m_nextBatchToApply(0) {
     setWindowTitle("VLC Playlist Creator");
+    setAcceptDrops(true);
 
     QWidget *centralWidget = new QWidget(this);
     QVBoxLayout *mainLayout = new QVBoxLayout(centralWidget);
@@ -26,9 +33,13 @@ VLCPlaylistCreator::VLCPlaylistCreator(QWidget *parent)
 
     QHBoxLayout *inputLayout = new QHBoxLayout();
     m_directoryInput = new QLineEdit(this);
+    m_directoryInput->setAcceptDrops(false); // Let drops reach the window's dropEvent
+    m_directoryInput->setPlaceholderText("One or more directories, separated by ';'");
     QPushButton *browseButton = new QPushButton("Browse", this);
+    QPushButton *addDirectoryButton = new QPushButton("Add Directory", this);
     inputLayout->addWidget(m_directoryInput);
     inputLayout->addWidget(browseButton);
+    inputLayout->addWidget(addDirectoryButton);
     processLayout->addLayout(inputLayout);
 
     m_verboseCheckbox = new QCheckBox("Verbose", this);
@@ -63,16 +74,20 @@ VLCPlaylistCreator::VLCPlaylistCreator(QWidget *parent)
     m_mainTabWidget->addTab(processTab, "Process Directory");
 
     // Manual Playlist Tab
-    QWidget *manualTab = new QWidget(this);
-    QVBoxLayout *manualLayout = new QVBoxLayout(manualTab);
+    m_manualTab = new QWidget(this);
+    QVBoxLayout *manualLayout = new QVBoxLayout(m_manualTab);
 
     QHBoxLayout *manualInputLayout = new QHBoxLayout();
     m_videoInput = new QLineEdit(this);
-    m_videoInput->setPlaceholderText("Enter video file path...");
+    m_videoInput->setAcceptDrops(false);
+    m_videoInput->setPlaceholderText("Enter video file or folder path, or drop files here...");
     manualInputLayout->addWidget(m_videoInput);
 
     QPushButton *browseVideoButton = new QPushButton("Browse", this);
     manualInputLayout->addWidget(browseVideoButton);
+
+    QPushButton *browseFolderButton = new QPushButton("Add Folder", this);
+    manualInputLayout->addWidget(browseFolderButton);
     manualLayout->addLayout(manualInputLayout);
 
     QPushButton *addButton = new QPushButton("Add to Playlist", this);
@@ -94,7 +109,7 @@ VLCPlaylistCreator::VLCPlaylistCreator(QWidget *parent)
     manualButtonLayout->addWidget(clearManualButton);
     manualLayout->addLayout(manualButtonLayout);
 
-    m_mainTabWidget->addTab(manualTab, "Manual Playlist");
+    m_mainTabWidget->addTab(m_manualTab, "Manual Playlist");
 
     // Create menu bar
     menuBar = new QMenuBar(this);
@@ -105,9 +120,11 @@ VLCPlaylistCreator::VLCPlaylistCreator(QWidget *parent)
     setMenuBar(menuBar);
 
     connect(browseButton, &QPushButton::clicked, this, &VLCPlaylistCreator::browseDirectory);
+    connect(addDirectoryButton, &QPushButton::clicked, this, &VLCPlaylistCreator::addDirectory);
     connect(processButton, &QPushButton::clicked, this, &VLCPlaylistCreator::processDirectory);
     connect(addButton, &QPushButton::clicked, this, &VLCPlaylistCreator::addVideoToPlaylist);
     connect(browseVideoButton, &QPushButton::clicked, this, &VLCPlaylistCreator::browseVideoFile);
+    connect(browseFolderButton, &QPushButton::clicked, this, &VLCPlaylistCreator::browseVideoFolder);
     connect(addVideoAction, &QAction::triggered, this, &VLCPlaylistCreator::openAddVideoDialog);
     connect(m_displayTabWidget, &QTabWidget::currentChanged, this, &VLCPlaylistCreator::switchDisplayMode);
     connect(processManualButton, &QPushButton::clicked, this, &VLCPlaylistCreator::processManualPlaylist);
@@ -116,7 +133,7 @@ VLCPlaylistCreator::VLCPlaylistCreator(QWidget *parent)
     resize(800, 600);
 }
 
-void VLCPlaylistCreator::browseDirectory() {
+QString VLCPlaylistCreator::chooseDirectory() {
     QFileDialog dialog(this);
     dialog.setFileMode(QFileDialog::Directory);
     dialog.setOption(QFileDialog::ShowDirsOnly, true);
@@ -131,15 +148,34 @@ void VLCPlaylistCreator::browseDirectory() {
         QStringList directories = dialog.selectedFiles();
         if (!directories.isEmpty()) {
             QString directory = directories.first();
-            m_directoryInput->setText(directory);
             saveLastDirectory(directory);
+            return directory;
+        }
+    }
+    return QString();
+}
+
+void VLCPlaylistCreator::browseDirectory() {
+    QString directory = chooseDirectory();
+    if (!directory.isEmpty()) {
+        m_directoryInput->setText(directory);
+    }
+}
+
+void VLCPlaylistCreator::addDirectory() {
+    QString directory = chooseDirectory();
+    if (!directory.isEmpty()) {
+        QStringList selected = getSelectedDirectories();
+        if (!selected.contains(VideoProcessor::normalizePath(directory))) {
+            selected.append(directory);
         }
+        m_directoryInput->setText(selected.join(";"));
     }
 }
 
 void VLCPlaylistCreator::processDirectory() {
-    QString directory = m_directoryInput->text();
-    if (directory.isEmpty()) {
+    QStringList directories = getSelectedDirectories();
+    if (directories.isEmpty()) {
         QMessageBox::warning(this, "Error", "Please select a directory.");
         return;
     }
@@ -153,7 +189,7 @@ void VLCPlaylistCreator::processDirectory() {
     VideoProcessor::SortType sortType = getCurrentSortType();
 
     QThread *thread = new QThread(this);
-    VideoProcessor *processor = new VideoProcessor(directory, verbose, sortType);
+    VideoProcessor *processor = new VideoProcessor(directories, verbose, sortType, m_runCache);
     processor->moveToThread(thread);
     connect(thread, &QThread::started, [processor, outputPath]() {
         processor->process(outputPath);
@@ -184,11 +220,14 @@ void VLCPlaylistCreator::processManualPlaylist() {
 
     VideoProcessor::SortType sortType = getCurrentSortType();
 
+    // Implicitly shared copy: the worker owns an immutable snapshot while the list keeps being edited here
+    const QStringList snapshot = m_videoPaths;
+
     QThread *thread = new QThread(this);
-    VideoProcessor *processor = new VideoProcessor("", false, sortType);
+    VideoProcessor *processor = new VideoProcessor(QStringList(), false, sortType, m_runCache);
     processor->moveToThread(thread);
-    connect(thread, &QThread::started, [processor, this, outputPath]() {
-        processor->processManualPlaylist(m_videoPaths, outputPath);
+    connect(thread, &QThread::started, [processor, snapshot, outputPath]() {
+        processor->processManualPlaylist(snapshot, outputPath);
     });
     connect(processor, &VideoProcessor::finished, thread, &QThread::quit);
     connect(processor, &VideoProcessor::finished, processor, &VideoProcessor::deleteLater);
@@ -201,6 +240,9 @@ void VLCPlaylistCreator::processManualPlaylist() {
     m_outputTextEdit->clear();
     m_logTextEdit->clear();
     appendLog("Processing manual playlist...");
+    if (m_pendingValidations > 0) {
+        appendLog("Entries still being validated are not included in this playlist.");
+    }
 }
 
 void VLCPlaylistCreator::updateOutput(const QString &output) {
@@ -222,10 +264,9 @@ void VLCPlaylistCreator::openAddVideoDialog() {
 }
 
 void VLCPlaylistCreator::addVideoToPlaylist() {
-    QString videoPath = m_videoInput->text();
+    QString videoPath = m_videoInput->text().trimmed();
     if (!videoPath.isEmpty()) {
-        m_videoPaths.append(videoPath);
-        updatePlaylistDisplay();
+        addVideoPaths(QStringList() << videoPath);
         m_videoInput->clear();
     } else {
         QMessageBox::warning(this, "Input Error", "Please enter a valid video file path.");
@@ -233,14 +274,108 @@ void VLCPlaylistCreator::addVideoToPlaylist() {
 }
 
 void VLCPlaylistCreator::browseVideoFile() {
-    QString videoPath = QFileDialog::getOpenFileName(this, "Select Video File", getLastDirectory());
-    if (!videoPath.isEmpty()) {
-        m_videoPaths.append(videoPath);
-        updatePlaylistDisplay();
-        saveLastDirectory(QFileInfo(videoPath).absolutePath());
+    QStringList patterns;
+    for (const QString &extension : VideoProcessor::videoExtensions()) {
+        patterns.append("*." + extension);
+    }
+    QStringList videoPaths = QFileDialog::getOpenFileNames(this, "Select Video Files", getLastDirectory(),
+        "Video Files (" + patterns.join(" ") + ");;All Files (*)");
+    if (!videoPaths.isEmpty()) {
+        addVideoPaths(videoPaths);
+        saveLastDirectory(QFileInfo(videoPaths.first()).absolutePath());
+    }
+}
+
+void VLCPlaylistCreator::browseVideoFolder() {
+    QString directory = QFileDialog::getExistingDirectory(this, "Select Video Folder", getLastDirectory());
+    if (!directory.isEmpty()) {
+        addVideoPaths(QStringList() << directory);
+        saveLastDirectory(directory);
+    }
+}
+
+void VLCPlaylistCreator::dragEnterEvent(QDragEnterEvent *event) {
+    for (const QUrl &url : event->mimeData()->urls()) {
+        if (url.isLocalFile()) {
+            event->acceptProposedAction();
+            return;
+        }
+    }
+}
+
+void VLCPlaylistCreator::dropEvent(QDropEvent *event) {
+    QStringList paths;
+    for (const QUrl &url : event->mimeData()->urls()) {
+        if (url.isLocalFile()) {
+            paths.append(url.toLocalFile());
+        }
+    }
+    if (!paths.isEmpty()) {
+        m_mainTabWidget->setCurrentWidget(m_manualTab);
+        addVideoPaths(paths);
+        event->acceptProposedAction();
     }
 }
 
+void VLCPlaylistCreator::addVideoPaths(const QStringList &paths) {
+    if (paths.isEmpty()) return;
+
+    // Stat calls and folder scans can take a while on large or network mounts, so keep them off the UI thread
+    int generation = m_validationGeneration;
+    int sequence = m_nextBatchSequence++;
+    m_pendingValidations++;
+    appendLog("Validating " + QString::number(paths.size()) + " entries...");
+
+    // Batches finish in any order; hold results back until every earlier batch is applied so the playlist keeps
+    // the order in which the user added entries
+    QFutureWatcher<VideoValidationResult> *watcher = new QFutureWatcher<VideoValidationResult>(this);
+    connect(watcher, &QFutureWatcher<VideoValidationResult>::finished, this, [this, watcher, generation, sequence]() {
+        m_pendingValidations--;
+        if (generation == m_validationGeneration) {
+            m_finishedBatches.insert(sequence, watcher->result());
+            while (m_finishedBatches.contains(m_nextBatchToApply)) {
+                applyValidationResult(m_finishedBatches.take(m_nextBatchToApply));
+                m_nextBatchToApply++;
+            }
+        }
+        watcher->deleteLater();
+    });
+    watcher->setFuture(QtConcurrent::run(&VideoProcessor::validateVideoFiles, paths));
+}
+
+void VLCPlaylistCreator::applyValidationResult(const VideoValidationResult &result) {
+    QStringList added;
+    int duplicates = result.duplicates;
+    for (const QString &videoPath : result.accepted) {
+        if (m_videoPathSet.contains(videoPath)) {
+            duplicates++;
+            continue;
+        }
+        m_videoPathSet.insert(videoPath);
+        added.append(videoPath);
+    }
+    m_videoPaths.append(added);
+
+    // Append only the new rows instead of rebuilding the whole list
+    QListWidget *currentListWidget = qobject_cast<QListWidget *>(m_displayTabWidget->currentWidget());
+    if (currentListWidget) {
+        QStringList items;
+        items.reserve(added.size());
+        for (const QString &videoPath : qAsConst(added)) {
+            items.append(displayText(videoPath));
+        }
+        currentListWidget->addItems(items);
+    }
+
+    QString message = "Added " + QString::number(added.size()) + " videos to the playlist";
+    if (result.missing + result.notVideo + duplicates > 0) {
+        message += " (skipped " + QString::number(result.missing) + " missing, "
+                   + QString::number(result.notVideo) + " non-video, "
+                   + QString::number(duplicates) + " duplicates)";
+    }
+    appendLog(message);
+}
+
 void VLCPlaylistCreator::switchDisplayMode(int /* index */) {
     updatePlaylistDisplay();
 }
@@ -249,19 +384,25 @@ void VLCPlaylistCreator::updatePlaylistDisplay() {
     QListWidget *currentListWidget = qobject_cast<QListWidget *>(m_displayTabWidget->currentWidget());
     if (!currentListWidget) return;
 
-    currentListWidget->clear();
+    QStringList items;
+    items.reserve(m_videoPaths.size());
     for (const QString &videoPath : qAsConst(m_videoPaths)) {
-        switch (m_displayTabWidget->currentIndex()) {
-            case 0: // Full Path
-                currentListWidget->addItem(videoPath);
-                break;
-            case 1: // File Name
-                currentListWidget->addItem(QFileInfo(videoPath).fileName());
-                break;
-            case 2: // Parent Folder
-                currentListWidget->addItem(QFileInfo(videoPath).absolutePath());
-                break;
-        }
+        items.append(displayText(videoPath));
+    }
+
+    currentListWidget->clear();
+    currentListWidget->addItems(items);
+}
+
+QString VLCPlaylistCreator::displayText(const QString &videoPath) const {
+    switch (m_displayTabWidget->currentIndex()) {
+        case 1: // File Name
+            return QFileInfo(videoPath).fileName();
+        case 2: // Parent Folder
+            return QFileInfo(videoPath).absolutePath();
+        case 0: // Full Path
+        default:
+            return videoPath;
     }
 }
 
@@ -300,12 +441,29 @@ QString VLCPlaylistCreator::getLastDirectory() {
     return m_settings.value("lastDirectory", QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation)).toString();
 }
 
+QStringList VLCPlaylistCreator::getSelectedDirectories() {
+    QStringList directories;
+    for (const QString &entry : m_directoryInput->text().split(';')) {
+        if (entry.trimmed().isEmpty()) continue;
+        QString directory = VideoProcessor::normalizePath(entry.trimmed());
+        if (!directories.contains(directory)) {
+            directories.append(directory);
+        }
+    }
+    return directories;
+}
+
 VideoProcessor::SortType VLCPlaylistCreator::getCurrentSortType() {
     return static_cast<VideoProcessor::SortType>(m_sortTypeComboBox->currentData().toInt());
 }
 
 void VLCPlaylistCreator::clearManualPlaylist() {
+    m_runCache->releaseEntries(m_videoPaths);
     m_videoPaths.clear();
+    m_videoPathSet.clear();
+    m_validationGeneration++; // Drop results of batches that were still being validated
+    m_finishedBatches.clear();
+    m_nextBatchToApply = m_nextBatchSequence;
     updatePlaylistDisplay();
     appendLog("Manual playlist cleared.");
 }
\ No newline at end of file
@@ -14,6 +14,11 @@
 #include <QSplitter>
 #include <QSettings>
 #include <QComboBox>
+#include <QSharedPointer>
+#include <QSet>
+#include <QMap>
+#include <QDragEnterEvent>
+#include <QDropEvent>
 #include "videoprocessor.h"
 
 class VLCPlaylistCreator : public QMainWindow {
@@ -22,8 +27,13 @@ class VLCPlaylistCreator : public QMainWindow {
 public:
     VLCPlaylistCreator(QWidget *parent = nullptr);
 
+protected:
+    void dragEnterEvent(QDragEnterEvent *event) override;
+    void dropEvent(QDropEvent *event) override;
+
 private slots:
     void browseDirectory();
+    void addDirectory();
     void processDirectory();
     void updateOutput(const QString &output);
     void displayError(const QString &error);
@@ -31,6 +41,7 @@ private slots:
     void openAddVideoDialog();
     void addVideoToPlaylist();
     void browseVideoFile();
+    void browseVideoFolder();
     void switchDisplayMode(int index);
     void processManualPlaylist();
     void clearManualPlaylist();
@@ -44,17 +55,30 @@ private:
     QLineEdit *m_videoInput;
     QListWidget *m_playlist;
     QTabWidget *m_mainTabWidget;
+    QWidget *m_manualTab;
     QTabWidget *m_displayTabWidget;
     QMenuBar *menuBar;
     QMenu *fileMenu;
     QAction *addVideoAction;
     QStringList m_videoPaths;
+    QSet<QString> m_videoPathSet;
     QSettings m_settings;
+    QSharedPointer<RunCache> m_runCache;
+    int m_pendingValidations;
+    int m_validationGeneration;
+    int m_nextBatchSequence;
+    int m_nextBatchToApply;
+    QMap<int, VideoValidationResult> m_finishedBatches;
 
     void updatePlaylistDisplay();
+    void addVideoPaths(const QStringList &paths);
+    void applyValidationResult(const VideoValidationResult &result);
+    QString displayText(const QString &videoPath) const;
     QString getOutputFilePath();
+    QString chooseDirectory();
     void saveLastDirectory(const QString &path);
     QString getLastDirectory();
+    QStringList getSelectedDirectories();
     VideoProcessor::SortType getCurrentSortType();
 };
 